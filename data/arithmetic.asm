@@ -16,13 +16,12 @@ add
 mov M A %c
 mov A M %c
 ldi B 11
-je %if_true_0
-jmp %if_end_1
-if_true_0:
+cmp
+jne %if_end_0
 mov A M %a
 ldi B 1
 add
 mov M A %a
-if_end_1:
+if_end_0:
 
 hlt
@@ -0,0 +1,39 @@
+#!/bin/sh
+# Times the serial lexer against `-j 1` .. `-j <max threads>` on a generated
+# program, e.g. `./scripts/bench_lexer.sh 2000000 8`. Only lexing is timed.
+# Run from the repository root; set ZINC to time an existing binary instead.
+# Arguments: number of statements (default 1000000), max threads (default nproc).
+set -e
+
+STATEMENTS=${1:-1000000}
+MAX_THREADS=${2:-$(nproc)}
+SOURCE=$(mktemp /tmp/zinc_bench_XXXXXX.sl)
+BUILD=$(mktemp /tmp/zinc_bench_XXXXXX)
+trap 'rm -f "$SOURCE" "$BUILD"' EXIT
+
+# the Makefile builds without optimisation, time an optimised build instead
+if [ -z "$ZINC" ]; then
+    g++ -O2 -pthread src/lexer.cpp src/parser.cpp src/codegen.cpp src/codegen_x86_64.cpp src/main.cpp -o "$BUILD"
+    ZINC=$BUILD
+fi
+
+awk -v n="$STATEMENTS" 'BEGIN {
+    print "int a;"; print "int b;"; print "int c;"
+    for(i = 0; i < n; i++) {
+        if(i % 10 == 0) {
+            print "if(a == b && c < 200) {\n    c = c + 1;\n}"
+        } else {
+            print "a = b + " (i % 256) " - c;"
+        }
+    }
+}' > "$SOURCE"
+
+echo "$(wc -c < "$SOURCE") bytes"
+printf 'serial: '
+"$ZINC" "$SOURCE" --time-lex 2>&1
+threads=1
+while [ "$threads" -le "$MAX_THREADS" ]; do
+    printf -- '-j %s: ' "$threads"
+    "$ZINC" "$SOURCE" -j "$threads" --time-lex 2>&1
+    threads=$((threads + 1))
+done
@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+"""
+Checks that the 8-bit and x86-64 targets agree. Every program is compiled for
+both targets; the 8-bit assembly is run on a small simulator of the
+instructions Zinc emits and the x86-64 assembly is linked with gcc and run
+natively. The final values of all variables must match.
+
+Usage: scripts/check_targets.py [program.sl ...]
+The zinc binary is taken from $ZINC, default ./zinc.
+"""
+
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+DEFAULT_PROGRAMS = ["data/arithmetic.sl", "data/relational.sl", "data/logical.sl"]
+
+# scratch memory the 8-bit target reserves for itself, not a program variable
+SCRATCH = {"cmp_tmp"}
+
+
+def run_eight_bit(assembly_path):
+    """Simulate the 8-bit assembly and return {variable: value}.
+
+    `cmp` sets Z when A == B and C when A < B, as documented in
+    docs/codegen.md. Memory starts out zeroed."""
+    addresses, program, labels = {}, [], {}
+    section = None
+    with open(assembly_path) as assembly:
+        for line in assembly:
+            line = line.strip()
+            if not line:
+                continue
+            if line in (".data", ".text"):
+                section = line
+            elif section == ".data":
+                name, address = line.split(" = ")
+                addresses[name] = int(address)
+            elif line.endswith(":"):
+                labels[line[:-1]] = len(program)
+            else:
+                program.append(line.split())
+
+    memory = {}
+    registers = {"A": 0, "B": 0}
+    zero = carry = False
+    pc = 0
+    while True:
+        instruction = program[pc]
+        pc += 1
+        op = instruction[0]
+        if op == "hlt":
+            break
+        elif op == "ldi":
+            registers[instruction[1]] = int(instruction[2]) % 256
+        elif op == "mov" and instruction[2] == "M":
+            registers[instruction[1]] = memory.get(addresses[instruction[3][1:]], 0)
+        elif op == "mov" and instruction[1] == "M":
+            memory[addresses[instruction[3][1:]]] = registers[instruction[2]]
+        elif op == "add":
+            registers["A"] = (registers["A"] + registers["B"]) % 256
+        elif op == "sub":
+            registers["A"] = (registers["A"] - registers["B"]) % 256
+        elif op == "cmp":
+            zero = registers["A"] == registers["B"]
+            carry = registers["A"] < registers["B"]
+        elif op in ("jmp", "je", "jne", "jc", "jnc"):
+            taken = {"jmp": True, "je": zero, "jne": not zero,
+                     "jc": carry, "jnc": not carry}[op]
+            if taken:
+                pc = labels[instruction[1][1:]]
+        else:
+            raise RuntimeError("unknown 8-bit instruction: " + " ".join(instruction))
+
+    return {name: memory.get(address, 0)
+            for name, address in addresses.items() if name not in SCRATCH}
+
+
+def run_native(assembly_path, workdir):
+    """Link the x86-64 assembly and return {variable: value}."""
+    executable = os.path.join(workdir, "program")
+    subprocess.run(["gcc", assembly_path, "-o", executable], check=True)
+    output = subprocess.run([executable], check=True, capture_output=True, text=True).stdout
+    values = {}
+    for line in output.splitlines():
+        name, value = line.split(" = ")
+        values[name] = int(value)
+    return values
+
+
+def compile_program(zinc, source, args, output):
+    if os.path.exists(output):
+        os.remove(output)
+    result = subprocess.run([zinc, source] + args, capture_output=True, text=True)
+    # zinc reports compile errors on stderr without failing
+    if result.returncode != 0 or result.stderr or not os.path.exists(output):
+        raise RuntimeError("zinc failed on {}: {}".format(source, result.stderr.strip()))
+
+
+def check(zinc, program):
+    with tempfile.TemporaryDirectory() as workdir:
+        source = os.path.join(workdir, "program.sl")
+        shutil.copy(program, source)
+        compile_program(zinc, source, [], os.path.join(workdir, "program.asm"))
+        compile_program(zinc, source, ["-t", "x86-64"], os.path.join(workdir, "program.s"))
+
+        eight_bit = run_eight_bit(os.path.join(workdir, "program.asm"))
+        native = run_native(os.path.join(workdir, "program.s"), workdir)
+
+    if eight_bit != native:
+        print("FAIL {}".format(program))
+        print("  8-bit:  {}".format(eight_bit))
+        print("  x86-64: {}".format(native))
+        return False
+    print("ok   {}: {}".format(program, ", ".join(
+        "{} = {}".format(name, value) for name, value in native.items())))
+    return True
+
+
+def main():
+    zinc = os.path.abspath(os.environ.get("ZINC", "./zinc"))
+    programs = sys.argv[1:] or DEFAULT_PROGRAMS
+    results = [check(zinc, program) for program in programs]
+    return 0 if all(results) else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
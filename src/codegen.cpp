@@ -1,27 +1,50 @@
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <string>
 #include <stdexcept>
 #include <iostream>
 #include <sstream>
+#include <utility>
 
-#include "parser.h"
+#include "codegen.h"
 
 
-std::vector<std::string> generateDeclaration(const ASTNode &node, std::unordered_map<std::string, int> &symbolTable, int &nextVarAddress) {
+std::vector<std::string> EightBitTarget::generateDataSection() {
+    return {".data\n"};
+}
+
+std::vector<std::string> EightBitTarget::generateDeclaration(const ASTNode &node) {
     std::vector<std::string> code;
     if(node.value.empty()) {
         throw std::runtime_error("Invalid declaration: No variable name");
     }
 
-    // adding variable to the symbol table
-    symbolTable[node.value] = nextVarAddress;
+    // every variable has always left the byte below it unused
     code.push_back(node.value + " = " + std::to_string(nextVarAddress));
-    nextVarAddress--;
+    nextVarAddress -= 2;
     return code;
 }
 
-std::vector<std::string> generateExpression(const ASTNode &node, const std::unordered_map<std::string, int> &symbolTable, const std::string &reg="A") {
+std::vector<std::string> EightBitTarget::generateReservedData() {
+    std::vector<std::string> code;
+    if(usesCompareScratch) {
+        // scratch byte that holds the `B` side of a comparison while `A` is loaded
+        code.push_back("cmp_tmp = " + std::to_string(nextVarAddress));
+        nextVarAddress--;
+    }
+    return code;
+}
+
+std::vector<std::string> EightBitTarget::generateTextSection() {
+    return {"\n.text\n"};
+}
+
+std::vector<std::string> EightBitTarget::generateExpression(const ASTNode &node, const std::unordered_set<std::string> &symbolTable) {
+    return generateExpressionInto(node, symbolTable, "A");
+}
+
+std::vector<std::string> EightBitTarget::generateExpressionInto(const ASTNode &node, const std::unordered_set<std::string> &symbolTable, const std::string &reg) {
     std::vector<std::string> code;
 
     if(node.type == "number") {
@@ -37,8 +60,12 @@ std::vector<std::string> generateExpression(const ASTNode &node, const std::unor
         if(node.children.find("left") == node.children.end() || node.children.find("right") == node.children.end()) {
             throw std::runtime_error("Binary operation must have 'left' and 'right' operand");
         }
-        std::vector<std::string> left = generateExpression(node.children.at("left")[0], symbolTable);
-        std::vector<std::string> right = generateExpression(node.children.at("right")[0], symbolTable, "B");
+        // `add` and `sub` always leave their result in A and clobber B
+        if(reg != "A") {
+            throw std::runtime_error("Binary operation can only be computed into register A");
+        }
+        std::vector<std::string> left = generateExpressionInto(node.children.at("left")[0], symbolTable, "A");
+        std::vector<std::string> right = generateExpressionInto(node.children.at("right")[0], symbolTable, "B");
 
         code.insert(code.end(), left.begin(), left.end());
         code.insert(code.end(), right.begin(), right.end());
@@ -65,22 +92,110 @@ std::string generateUniqueLabel(const std::string &base) {
     return label.str();
 }
 
-std::vector<std::string> generateCondition(const ASTNode &node, const std::unordered_map<std::string, int> &symbolTable) {
+std::vector<std::string> EightBitTarget::generateComparison(const ASTNode &node, const std::unordered_set<std::string> &symbolTable, const std::string &label, bool jumpWhen) {
     std::vector<std::string> code;
-    if(node.value == "==") {
-        std::vector<std::string> leftCode = generateExpression(node.children.at("left")[0], symbolTable, "A");
-        std::vector<std::string> rightCode = generateExpression(node.children.at("right")[0], symbolTable, "B");
 
-        code.insert(code.end(), leftCode.begin(), leftCode.end());
-        code.insert(code.end(), rightCode.begin(), rightCode.end());
+    // `cmp A B` sets Z when A == B and C when A < B, so `>` and `<=`
+    // load the operands the other way round and reuse the same jumps
+    bool swapOperands = false;
+    std::string jumpIfTrue, jumpIfFalse;
+    if(node.value == "==") {
+        jumpIfTrue = "je";
+        jumpIfFalse = "jne";
+    } else if(node.value == "!=") {
+        jumpIfTrue = "jne";
+        jumpIfFalse = "je";
+    } else if(node.value == "<") {
+        jumpIfTrue = "jc";
+        jumpIfFalse = "jnc";
+    } else if(node.value == ">=") {
+        jumpIfTrue = "jnc";
+        jumpIfFalse = "jc";
+    } else if(node.value == ">") {
+        swapOperands = true;
+        jumpIfTrue = "jc";
+        jumpIfFalse = "jnc";
+    } else if(node.value == "<=") {
+        swapOperands = true;
+        jumpIfTrue = "jnc";
+        jumpIfFalse = "jc";
     } else {
         throw std::runtime_error("Unsupported condition operation: " + node.value);
     }
+
+    const ASTNode *aSide = &node.children.at("left")[0];
+    const ASTNode *bSide = &node.children.at("right")[0];
+    if(swapOperands) {
+        std::swap(aSide, bSide);
+    }
+    // `==` and `!=` are symmetric, so keep a compound side out of B if we can
+    if((node.value == "==" || node.value == "!=") && bSide->type == "binary_op" && aSide->type != "binary_op") {
+        std::swap(aSide, bSide);
+    }
+
+    if(bSide->type == "binary_op") {
+        // a compound B side is computed in A, so compute it first and
+        // park it in memory before A is loaded
+        usesCompareScratch = true;
+        std::vector<std::string> bCode = generateExpression(*bSide, symbolTable);
+        std::vector<std::string> aCode = generateExpression(*aSide, symbolTable);
+        code.insert(code.end(), bCode.begin(), bCode.end());
+        code.push_back("mov M A %cmp_tmp");
+        code.insert(code.end(), aCode.begin(), aCode.end());
+        code.push_back("mov B M %cmp_tmp");
+    } else {
+        std::vector<std::string> aCode = generateExpression(*aSide, symbolTable);
+        std::vector<std::string> bCode = generateExpressionInto(*bSide, symbolTable, "B");
+        code.insert(code.end(), aCode.begin(), aCode.end());
+        code.insert(code.end(), bCode.begin(), bCode.end());
+    }
+    code.push_back("cmp");
+    code.push_back((jumpWhen ? jumpIfTrue : jumpIfFalse) + " %" + label);
+    return code;
+}
+
+/* Emit code that jumps to `label` when the condition is equal to `jumpWhen`
+and falls through otherwise. `&&` and `||` short-circuit by branching on each
+operand in turn, so no boolean value is ever stored in a register. */
+std::vector<std::string> generateCondition(Target &target, const ASTNode &node, const std::unordered_set<std::string> &symbolTable, const std::string &label, bool jumpWhen) {
+    std::vector<std::string> code;
+    if(node.type == "condition") {
+        return target.generateComparison(node, symbolTable, label, jumpWhen);
+    } else if(node.type == "logical_not") {
+        return generateCondition(target, node.children.at("operand")[0], symbolTable, label, !jumpWhen);
+    } else if(node.type == "logical_op") {
+        if(node.value != "&&" && node.value != "||") {
+            throw std::runtime_error("Unsupported logical operation: " + node.value);
+        }
+        const ASTNode &left = node.children.at("left")[0];
+        const ASTNode &right = node.children.at("right")[0];
+
+        // `a && b` is false as soon as `a` is false, `a || b` is true as
+        // soon as `a` is true. Either way the left operand decides alone.
+        bool leftDecides = (node.value == "||");
+        std::vector<std::string> leftCode, rightCode;
+        if(leftDecides == jumpWhen) {
+            leftCode = generateCondition(target, left, symbolTable, label, jumpWhen);
+            rightCode = generateCondition(target, right, symbolTable, label, jumpWhen);
+            code.insert(code.end(), leftCode.begin(), leftCode.end());
+            code.insert(code.end(), rightCode.begin(), rightCode.end());
+        } else {
+            // the left operand can only rule the jump out, skip past the right one
+            std::string skipLabel = generateUniqueLabel("cond_skip");
+            leftCode = generateCondition(target, left, symbolTable, skipLabel, leftDecides);
+            rightCode = generateCondition(target, right, symbolTable, label, jumpWhen);
+            code.insert(code.end(), leftCode.begin(), leftCode.end());
+            code.insert(code.end(), rightCode.begin(), rightCode.end());
+            code.push_back(skipLabel + ":");
+        }
+    } else {
+        throw std::runtime_error("Unsupported condition node: " + node.type);
+    }
     return code;
 }
 
 
-std::vector<std::string> generateAssignment(const ASTNode &node, const std::unordered_map<std::string, int> &symbolTable) {
+std::vector<std::string> EightBitTarget::generateAssignment(const ASTNode &node, const std::unordered_set<std::string> &symbolTable) {
     std::vector<std::string> code;
     std::string varName = node.value; // variable for assignment
 
@@ -90,32 +205,34 @@ std::vector<std::string> generateAssignment(const ASTNode &node, const std::unor
     }
 
     if(node.children.find("expression") == node.children.end()) {
-        std::runtime_error("Assignment node missing 'expression' child");
+        throw std::runtime_error("Assignment node missing 'expression' child");
     }
 
     const ASTNode &expression = node.children.at("expression")[0];
-    auto expressionCode = generateExpression(expression, symbolTable, "A");
+    auto expressionCode = generateExpression(expression, symbolTable);
     code.insert(code.end(), expressionCode.begin(), expressionCode.end());
 
     code.push_back("mov M A %" + varName); // store the variable data in memory
     return code;
 }
 
-std::vector<std::string> generateIf(const ASTNode &node, std::unordered_map<std::string, int> &symbolTable) {
+std::vector<std::string> EightBitTarget::generateProgramEnd() {
+    return {"\nhlt"};
+}
+
+/* Shared by all targets, the condition and the statements in the body
+are lowered through the target hooks. */
+std::vector<std::string> Target::generateIf(const ASTNode &node, const std::unordered_set<std::string> &symbolTable) {
     std::vector<std::string> code;
-    std::string iftrueLabel = generateUniqueLabel("if_true");
     std::string ifendLabel = generateUniqueLabel("if_end");
 
+    // skip the if-block when the condition is false
     const ASTNode &conditionNode = node.children.at("condition")[0];
-    std::vector<std::string> conditionCode = generateCondition(conditionNode, symbolTable);
+    std::vector<std::string> conditionCode = generateCondition(*this, conditionNode, symbolTable, ifendLabel, false);
 
     code.insert(code.end(), conditionCode.begin(), conditionCode.end());
 
-    code.push_back("je %" + iftrueLabel); // jump here if A == B
-    code.push_back("jmp %" + ifendLabel); // jump here if A != B
-
     // generate code for if-block
-    code.push_back(iftrueLabel + ":");
     const auto &blockStatements = node.children.at("body")[0];
     if(blockStatements.type == "statement_list") {
         const auto &bodyStatements = blockStatements.children.at("statements");
@@ -140,17 +257,15 @@ std::vector<std::string> generateIf(const ASTNode &node, std::unordered_map<std:
 }
 
 
-std::vector<std::string> generateProgram(const ASTNode &ast) {
+std::vector<std::string> generateProgram(const ASTNode &ast, Target &target) {
     // maintain a symbol table to track all declared variables
-    std::unordered_map<std::string, int> symbolTable;
-
-    // data addresses start from 255 and decrease. memory => 255 bytes
-    int nextVarAddress = 255;
+    std::unordered_set<std::string> symbolTable;
 
     // store all the code in vec of strings
     std::vector<std::string> code;
 
-    code.push_back(".data\n");
+    auto dataCode = target.generateDataSection();
+    code.insert(code.end(), dataCode.begin(), dataCode.end());
 
     auto stmtList = ast.children.find("statements");
     if(stmtList == ast.children.end()) {
@@ -159,26 +274,38 @@ std::vector<std::string> generateProgram(const ASTNode &ast) {
 
     for(const auto &stmt : stmtList->second) {
         if(stmt.type == "declaration") {
-            auto declCode = generateDeclaration(stmt, symbolTable, nextVarAddress);
+            // checked here so every target accepts the same programs
+            if(symbolTable.find(stmt.value) != symbolTable.end()) {
+                throw std::runtime_error("Variable declared twice: " + stmt.value);
+            }
+            symbolTable.insert(stmt.value);
+            auto declCode = target.generateDeclaration(stmt);
             code.insert(code.end(), declCode.begin(), declCode.end());
-            nextVarAddress--;
         }
     }
 
-    code.push_back("\n.text\n");
-
+    // lower the statements first so the target knows what scratch data it needs
+    std::vector<std::string> statementCode;
     for(const auto &stmt : stmtList->second) {
         if(stmt.type == "assignment") {
-            auto assignCode = generateAssignment(stmt, symbolTable);
-            code.insert(code.end(), assignCode.begin(), assignCode.end());
+            auto assignCode = target.generateAssignment(stmt, symbolTable);
+            statementCode.insert(statementCode.end(), assignCode.begin(), assignCode.end());
         }
         else if(stmt.type == "conditional") {
-            auto ifCode = generateIf(stmt, symbolTable);
-            code.insert(code.end(), ifCode.begin(), ifCode.end());
+            auto ifCode = target.generateIf(stmt, symbolTable);
+            statementCode.insert(statementCode.end(), ifCode.begin(), ifCode.end());
         }
     }
 
-    code.push_back("\nhlt");
+    auto reservedCode = target.generateReservedData();
+    code.insert(code.end(), reservedCode.begin(), reservedCode.end());
+
+    auto textCode = target.generateTextSection();
+    code.insert(code.end(), textCode.begin(), textCode.end());
+    code.insert(code.end(), statementCode.begin(), statementCode.end());
+
+    auto endCode = target.generateProgramEnd();
+    code.insert(code.end(), endCode.begin(), endCode.end());
     return code;
 
 }
\ No newline at end of file
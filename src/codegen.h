@@ -3,24 +3,91 @@
 
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <string>
 #include <string>
 #include <stdexcept>
 
 #include "parser.h"
 
-std::string generateUniqueLabel(const std::string &base);
+/* Hooks a backend implements to lower the AST to its own assembly.
+`generateProgram` walks the AST and calls into the target for every
+construct, so a new backend only has to override these. The symbol
+table only records which variables are declared, where they live is up
+to the target. */
+struct Target {
+    virtual ~Target() {}
+
+    virtual std::vector<std::string> generateDataSection() = 0;
+
+    // the name has already been checked and added to the symbol table
+    virtual std::vector<std::string> generateDeclaration(const ASTNode &node) = 0;
+
+    // scratch data the target needed while lowering the statements, emitted
+    // after the declarations once the whole program has been lowered
+    virtual std::vector<std::string> generateReservedData() { return {}; }
+
+    virtual std::vector<std::string> generateTextSection() = 0;
+
+    // compute the expression into the target's result register
+    virtual std::vector<std::string> generateExpression(const ASTNode &node, const std::unordered_set<std::string> &symbolTable) = 0;
+
+    virtual std::vector<std::string> generateAssignment(const ASTNode &node, const std::unordered_set<std::string> &symbolTable) = 0;
+
+    // compare the two sides and jump to `label` when the result equals `jumpWhen`
+    virtual std::vector<std::string> generateComparison(const ASTNode &node, const std::unordered_set<std::string> &symbolTable, const std::string &label, bool jumpWhen) = 0;
 
-std::vector<std::string> generateDeclaration(const ASTNode &node, std::unordered_map<std::string, int> &symbolTable, int &nextVarAddress);
+    virtual std::vector<std::string> generateIf(const ASTNode &node, const std::unordered_set<std::string> &symbolTable);
 
-std::vector<std::string> generateAssignment(const ASTNode &node, const std::unordered_map<std::string, int> &symbolTable);
+    virtual std::vector<std::string> generateProgramEnd() = 0;
+};
 
-std::vector<std::string> generateExpression(const ASTNode &node, const std::unordered_map<std::string, int> &symbolTable, const std::string &reg="A");
+/* Assembly for the 8-bit computer, registers A and B, variables in memory */
+struct EightBitTarget : Target {
+    std::vector<std::string> generateDataSection() override;
+    std::vector<std::string> generateDeclaration(const ASTNode &node) override;
+    std::vector<std::string> generateReservedData() override;
+    std::vector<std::string> generateTextSection() override;
+    std::vector<std::string> generateExpression(const ASTNode &node, const std::unordered_set<std::string> &symbolTable) override;
+    std::vector<std::string> generateAssignment(const ASTNode &node, const std::unordered_set<std::string> &symbolTable) override;
+    std::vector<std::string> generateComparison(const ASTNode &node, const std::unordered_set<std::string> &symbolTable, const std::string &label, bool jumpWhen) override;
+    std::vector<std::string> generateProgramEnd() override;
 
-std::vector<std::string> generateCondition(const ASTNode &node, const std::unordered_map<std::string, int> &symbolTable);
+private:
+    // compute the expression into register `reg`, either A or B
+    std::vector<std::string> generateExpressionInto(const ASTNode &node, const std::unordered_set<std::string> &symbolTable, const std::string &reg);
+
+    // data addresses start from 255 and decrease. memory => 255 bytes
+    int nextVarAddress = 255;
+
+    // set once a comparison has to park its B side in `cmp_tmp`
+    bool usesCompareScratch = false;
+};
+
+/* GNU assembler source for x86-64 Linux. Values live in 8-bit registers so
+arithmetic wraps around like on the 8-bit computer, and `main` prints the
+final value of every variable. */
+struct X86_64Target : Target {
+    std::vector<std::string> generateDataSection() override;
+    std::vector<std::string> generateDeclaration(const ASTNode &node) override;
+    std::vector<std::string> generateTextSection() override;
+    std::vector<std::string> generateExpression(const ASTNode &node, const std::unordered_set<std::string> &symbolTable) override;
+    std::vector<std::string> generateAssignment(const ASTNode &node, const std::unordered_set<std::string> &symbolTable) override;
+    std::vector<std::string> generateComparison(const ASTNode &node, const std::unordered_set<std::string> &symbolTable, const std::string &label, bool jumpWhen) override;
+    std::vector<std::string> generateProgramEnd() override;
+
+private:
+    // compute the expression into the 8-bit register `reg`
+    std::vector<std::string> generateExpressionInto(const ASTNode &node, const std::unordered_set<std::string> &symbolTable, const std::string &reg);
+
+    // variables in declaration order, printed at the end of the program
+    std::vector<std::string> variables;
+};
+
+std::string generateUniqueLabel(const std::string &base);
 
-std::vector<std::string> generateIf(const ASTNode &node, const std::unordered_map<std::string, int> &symbolTable);
+std::vector<std::string> generateCondition(Target &target, const ASTNode &node, const std::unordered_set<std::string> &symbolTable, const std::string &label, bool jumpWhen);
 
-std::vector<std::string> generateProgram(const ASTNode &ast);
+std::vector<std::string> generateProgram(const ASTNode &ast, Target &target);
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,212 @@
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <string>
+#include <stdexcept>
+
+#include "codegen.h"
+
+/*
+x86-64 backend. Variables are bytes in .bss and every value is computed in
+an 8-bit register (al, cl, dl), so `+` and `-` wrap around modulo 256 and
+comparisons are unsigned, the same as on the 8-bit computer.
+*/
+
+std::string x86Variable(const std::string &name) {
+    return ".Lvar_" + name;
+}
+
+// numbers are reduced modulo 256, the way the 8-bit registers hold them
+std::string x86Number(const std::string &value) {
+    int number = 0;
+    for(char digit : value) {
+        number = (number * 10 + (digit - '0')) % 256;
+    }
+    return std::to_string(number);
+}
+
+/* Returns the term as an immediate or memory operand, or an empty string
+if the node has to be computed into a register first. */
+std::string x86Operand(const ASTNode &node, const std::unordered_set<std::string> &symbolTable) {
+    if(node.type == "number") {
+        return x86Number(node.value);
+    }
+    if(node.type == "identifier") {
+        if(symbolTable.find(node.value) == symbolTable.end()) {
+            throw std::runtime_error("Undefined variable: " + node.value);
+        }
+        return "BYTE PTR [rip + " + x86Variable(node.value) + "]";
+    }
+    return "";
+}
+
+// the register used to hold the right operand when `reg` holds the left one
+std::string x86ScratchRegister(const std::string &reg) {
+    if(reg == "al") {
+        return "cl";
+    } else if(reg == "cl") {
+        return "dl";
+    }
+    throw std::runtime_error("Expression too deep: no scratch register after " + reg);
+}
+
+std::vector<std::string> X86_64Target::generateDataSection() {
+    return {"    .intel_syntax noprefix", "    .bss"};
+}
+
+std::vector<std::string> X86_64Target::generateDeclaration(const ASTNode &node) {
+    std::vector<std::string> code;
+    if(node.value.empty()) {
+        throw std::runtime_error("Invalid declaration: No variable name");
+    }
+
+    variables.push_back(node.value);
+    code.push_back(x86Variable(node.value) + ":");
+    code.push_back("    .zero 1");
+    return code;
+}
+
+std::vector<std::string> X86_64Target::generateTextSection() {
+    return {
+        "",
+        "    .text",
+        "    .globl main",
+        "main:",
+        "    push rbp",
+        "    mov rbp, rsp"
+    };
+}
+
+std::vector<std::string> X86_64Target::generateExpression(const ASTNode &node, const std::unordered_set<std::string> &symbolTable) {
+    return generateExpressionInto(node, symbolTable, "al");
+}
+
+std::vector<std::string> X86_64Target::generateExpressionInto(const ASTNode &node, const std::unordered_set<std::string> &symbolTable, const std::string &reg) {
+    std::vector<std::string> code;
+
+    std::string operand = x86Operand(node, symbolTable);
+    if(!operand.empty()) {
+        code.push_back("    mov " + reg + ", " + operand);
+    }
+    else if(node.type == "binary_op") {
+        if(node.children.find("left") == node.children.end() || node.children.find("right") == node.children.end()) {
+            throw std::runtime_error("Binary operation must have 'left' and 'right' operand");
+        }
+        std::string instruction;
+        if(node.value == "+") {
+            instruction = "add";
+        }
+        else if(node.value == "-") {
+            instruction = "sub";
+        }
+        else {
+            throw std::runtime_error("Unsupported binary operation: " + node.value);
+        }
+
+        std::vector<std::string> left = generateExpressionInto(node.children.at("left")[0], symbolTable, reg);
+        code.insert(code.end(), left.begin(), left.end());
+
+        // a term is used directly as the second operand
+        const ASTNode &rightNode = node.children.at("right")[0];
+        std::string right = x86Operand(rightNode, symbolTable);
+        if(right.empty()) {
+            right = x86ScratchRegister(reg);
+            std::vector<std::string> rightCode = generateExpressionInto(rightNode, symbolTable, right);
+            code.insert(code.end(), rightCode.begin(), rightCode.end());
+        }
+        code.push_back("    " + instruction + " " + reg + ", " + right);
+    } else {
+        throw std::runtime_error("Unsupported node type: " + node.type);
+    }
+    return code;
+}
+
+std::vector<std::string> X86_64Target::generateAssignment(const ASTNode &node, const std::unordered_set<std::string> &symbolTable) {
+    std::vector<std::string> code;
+    std::string varName = node.value; // variable for assignment
+
+    // check if it exists
+    if(symbolTable.find(varName) == symbolTable.end()) {
+        throw std::runtime_error("Undefined variable: " + varName);
+    }
+
+    if(node.children.find("expression") == node.children.end()) {
+        throw std::runtime_error("Assignment node missing 'expression' child");
+    }
+
+    const ASTNode &expression = node.children.at("expression")[0];
+    auto expressionCode = generateExpression(expression, symbolTable);
+    code.insert(code.end(), expressionCode.begin(), expressionCode.end());
+
+    code.push_back("    mov BYTE PTR [rip + " + x86Variable(varName) + "], al");
+    return code;
+}
+
+std::vector<std::string> X86_64Target::generateComparison(const ASTNode &node, const std::unordered_set<std::string> &symbolTable, const std::string &label, bool jumpWhen) {
+    std::vector<std::string> code;
+
+    // values are unsigned bytes, so use the below/above jumps
+    std::string jumpIfTrue, jumpIfFalse;
+    if(node.value == "==") {
+        jumpIfTrue = "je";
+        jumpIfFalse = "jne";
+    } else if(node.value == "!=") {
+        jumpIfTrue = "jne";
+        jumpIfFalse = "je";
+    } else if(node.value == "<") {
+        jumpIfTrue = "jb";
+        jumpIfFalse = "jae";
+    } else if(node.value == ">=") {
+        jumpIfTrue = "jae";
+        jumpIfFalse = "jb";
+    } else if(node.value == ">") {
+        jumpIfTrue = "ja";
+        jumpIfFalse = "jbe";
+    } else if(node.value == "<=") {
+        jumpIfTrue = "jbe";
+        jumpIfFalse = "ja";
+    } else {
+        throw std::runtime_error("Unsupported condition operation: " + node.value);
+    }
+
+    std::vector<std::string> leftCode = generateExpression(node.children.at("left")[0], symbolTable);
+    code.insert(code.end(), leftCode.begin(), leftCode.end());
+
+    const ASTNode &rightNode = node.children.at("right")[0];
+    std::string right = x86Operand(rightNode, symbolTable);
+    if(right.empty()) {
+        right = "cl";
+        std::vector<std::string> rightCode = generateExpressionInto(rightNode, symbolTable, right);
+        code.insert(code.end(), rightCode.begin(), rightCode.end());
+    }
+    code.push_back("    cmp al, " + right);
+    code.push_back("    " + (jumpWhen ? jumpIfTrue : jumpIfFalse) + " " + label);
+    return code;
+}
+
+std::vector<std::string> X86_64Target::generateProgramEnd() {
+    std::vector<std::string> code;
+
+    // print the final value of every variable as `name = value`
+    for(const auto &name : variables) {
+        code.push_back("    lea rdi, [rip + .Lformat]");
+        code.push_back("    lea rsi, [rip + .Lname_" + name + "]");
+        code.push_back("    movzx edx, BYTE PTR [rip + " + x86Variable(name) + "]");
+        code.push_back("    xor eax, eax");
+        code.push_back("    call printf@PLT");
+    }
+    code.push_back("    xor eax, eax");
+    code.push_back("    pop rbp");
+    code.push_back("    ret");
+
+    code.push_back("");
+    code.push_back("    .section .rodata");
+    code.push_back(".Lformat:");
+    code.push_back("    .string \"%s = %u\\n\"");
+    for(const auto &name : variables) {
+        code.push_back(".Lname_" + name + ":");
+        code.push_back("    .string \"" + name + "\"");
+    }
+    code.push_back("    .section .note.GNU-stack,\"\",@progbits");
+    return code;
+}
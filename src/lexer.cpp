@@ -2,31 +2,42 @@
 #include <string.h>
 #include <string>
 #include <fstream>
+#include <sstream>
 #include <vector>
+#include <thread>
+#include <algorithm>
 #include <iostream>
 
 #include "lexer.h"
 
-/* Function takes the input file stream and returns
-the next token. Each of these tokens will be added to
-vector for tokens. */
-Token getNextToken(std::ifstream &fileStream) {
-    char ch;
+/* Function takes the source buffer and the current position
+inside the range [pos, end) and returns the next token. `line`
+counts the newlines consumed so far, relative to the start of
+the range. Each of these tokens will be added to vector for tokens. */
+Token getNextToken(const std::string &source, size_t &pos, size_t end, size_t &line) {
     Token token;
     token.text.clear();
-    while(fileStream.get(ch)) {
+    while(pos < end) {
+        char ch = source[pos];
         if(std::isspace(ch)) {
             // ignore empty spaces
+            if(ch == '\n') {
+                line++;
+            }
+            pos++;
             continue;
         }
-        
+
+        token.offset = pos;
+        token.line = line;
+
         // now for alphanumeric chars
         if(std::isalpha(ch)) {
-            token.text = ch;
-            while(fileStream.get(ch) && (std::isalnum(ch))) {
-                token.text += ch;
+            size_t start = pos++;
+            while(pos < end && std::isalnum(source[pos])) {
+                pos++;
             }
-            fileStream.unget();
+            token.text = source.substr(start, pos - start);
 
             if(token.text == "if") {
                 token.type = TOKEN_IF;
@@ -41,33 +52,77 @@ Token getNextToken(std::ifstream &fileStream) {
 
         // checking for numbers
         if(std::isdigit(ch)) {
-            token.text = ch;
-            while(fileStream.get(ch)) {
-                if(std::isdigit(ch)) {
-                    token.text += ch;
-                } else {
-                    fileStream.unget();
-                    break;
-                }
+            size_t start = pos++;
+            while(pos < end && std::isdigit(source[pos])) {
+                pos++;
             }
+            token.text = source.substr(start, pos - start);
             token.type = TOKEN_NUMBER;
             return token;
         }
-        
+
         // checking for single character tokens
+        pos++;
         switch(ch) {
             case '=':
                 token.text = "=";
-                if(fileStream.get(ch)) {
-                    // checking for `==` for `if` conditions`
-                    if(ch == '=') {
-                        token.text += ch;
-                        token.type = TOKEN_EQUAL;
-                        return token;
-                    }
+                // checking for `==` for `if` conditions`
+                if(pos < end && source[pos] == '=') {
+                    token.text += '=';
+                    token.type = TOKEN_EQUAL;
+                    pos++;
+                    return token;
                 }
                 token.type = TOKEN_ASSIGN;
                 return token;
+            case '!':
+                token.text = "!";
+                if(pos < end && source[pos] == '=') {
+                    token.text += '=';
+                    token.type = TOKEN_NOT_EQUAL;
+                    pos++;
+                    return token;
+                }
+                token.type = TOKEN_NOT;
+                return token;
+            case '<':
+                token.text = "<";
+                if(pos < end && source[pos] == '=') {
+                    token.text += '=';
+                    token.type = TOKEN_LESS_EQUAL;
+                    pos++;
+                    return token;
+                }
+                token.type = TOKEN_LESS;
+                return token;
+            case '>':
+                token.text = ">";
+                if(pos < end && source[pos] == '=') {
+                    token.text += '=';
+                    token.type = TOKEN_GREATER_EQUAL;
+                    pos++;
+                    return token;
+                }
+                token.type = TOKEN_GREATER;
+                return token;
+            case '&':
+                // a single `&` is not a token
+                if(pos < end && source[pos] == '&') {
+                    token.text = "&&";
+                    token.type = TOKEN_AND;
+                    pos++;
+                    return token;
+                }
+                break;
+            case '|':
+                // a single `|` is not a token
+                if(pos < end && source[pos] == '|') {
+                    token.text = "||";
+                    token.type = TOKEN_OR;
+                    pos++;
+                    return token;
+                }
+                break;
             case '+':
                 token.text = "+";
                 token.type = TOKEN_ADD;
@@ -102,17 +157,36 @@ Token getNextToken(std::ifstream &fileStream) {
     }
     token.text = "";
     token.type = TOKEN_EOF;
+    token.offset = end;
+    token.line = line;
     return token;
 }
 
-std::vector<Token> tokenizeFile(const std::string filePath) {
+/* Tokenize the range [begin, end) of the source. Line numbers of the
+returned tokens are relative to the start of the range and `newlines`
+receives the number of newlines in the range. The EOF token is not
+included. */
+std::vector<Token> tokenizeChunk(const std::string &source, size_t begin, size_t end, size_t &newlines) {
+    std::vector<Token> chunkTokens;
+    size_t pos = begin;
+    size_t line = 0;
+    Token token = getNextToken(source, pos, end, line);
+    while(token.type != TOKEN_EOF) {
+        chunkTokens.push_back(std::move(token));
+        token = getNextToken(source, pos, end, line);
+    }
+    newlines = line;
+    return chunkTokens;
+}
+
+std::string readSource(const std::string &filePath) {
     std::ifstream file;
     file.open(filePath);
 
     // check for error during file read
     if(!file.is_open()) {
         perror("Error: Could not open file\n");
-        
+
         if(file.bad()) {
             perror("Fatal error: Badbit is set\n");
         }
@@ -122,13 +196,108 @@ std::vector<Token> tokenizeFile(const std::string filePath) {
         }
     }
 
-    std::vector<Token> programTokens;
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+Token makeEOFToken(const std::string &source, size_t line) {
     Token token;
-    do {
-        token = getNextToken(file);
-        programTokens.push_back(token);
-    } while(token.type != TOKEN_EOF);
+    token.text = "";
+    token.type = TOKEN_EOF;
+    token.offset = source.size();
+    token.line = line;
+    return token;
+}
+
+std::vector<Token> tokenizeSource(const std::string &source) {
+    size_t newlines = 0;
+    std::vector<Token> programTokens = tokenizeChunk(source, 0, source.size(), newlines);
+    for(auto &token : programTokens) {
+        token.line += 1;
+    }
+    programTokens.push_back(makeEOFToken(source, newlines + 1));
 
     return programTokens;
 }
 
+std::vector<Token> tokenizeFile(const std::string filePath) {
+    return tokenizeSource(readSource(filePath));
+}
+
+/* Split the source into at most `numChunks` ranges. Every range except
+the last ends right after a `;` or `}`, neither of which can be part of
+a longer token, so each range can be lexed on its own. */
+std::vector<size_t> splitSource(const std::string &source, unsigned numChunks) {
+    std::vector<size_t> bounds = {0};
+    size_t chunkSize = source.size() / numChunks;
+    for(unsigned i = 1; i < numChunks; i++) {
+        size_t pos = std::max(i * chunkSize, bounds.back());
+        while(pos < source.size() && source[pos] != ';' && source[pos] != '}') {
+            pos++;
+        }
+        if(pos >= source.size()) {
+            break;
+        }
+        bounds.push_back(pos + 1);
+    }
+    if(bounds.back() != source.size()) {
+        bounds.push_back(source.size());
+    }
+    return bounds;
+}
+
+std::vector<Token> tokenizeFileParallel(const std::string filePath, unsigned numThreads) {
+    if(numThreads == 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::string source = readSource(filePath);
+    std::vector<size_t> bounds = splitSource(source, numThreads);
+    size_t numChunks = bounds.size() - 1;
+
+    // a single chunk gains nothing from a worker thread and the stitching pass
+    if(numChunks <= 1) {
+        return tokenizeSource(source);
+    }
+
+    // lex every chunk into its own token array
+    std::vector<std::vector<Token>> chunkTokens(numChunks);
+    std::vector<size_t> chunkNewlines(numChunks, 0);
+    std::vector<std::thread> workers;
+    for(size_t i = 0; i < numChunks; i++) {
+        workers.emplace_back([&, i]() {
+            chunkTokens[i] = tokenizeChunk(source, bounds[i], bounds[i + 1], chunkNewlines[i]);
+        });
+    }
+    for(auto &worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+
+    // prefix sums give each chunk its first token index and first line
+    std::vector<size_t> tokenStart(numChunks + 1, 0);
+    std::vector<size_t> lineStart(numChunks + 1, 1);
+    for(size_t i = 0; i < numChunks; i++) {
+        tokenStart[i + 1] = tokenStart[i] + chunkTokens[i].size();
+        lineStart[i + 1] = lineStart[i] + chunkNewlines[i];
+    }
+
+    // stitch the chunks into one contiguous stream
+    std::vector<Token> programTokens(tokenStart[numChunks] + 1);
+    for(size_t i = 0; i < numChunks; i++) {
+        workers.emplace_back([&, i]() {
+            size_t out = tokenStart[i];
+            for(auto &token : chunkTokens[i]) {
+                token.line += lineStart[i];
+                programTokens[out++] = std::move(token);
+            }
+        });
+    }
+    for(auto &worker : workers) {
+        worker.join();
+    }
+    programTokens.back() = makeEOFToken(source, lineStart[numChunks]);
+
+    return programTokens;
+}
@@ -14,6 +14,14 @@ typedef enum {
     TOKEN_SUBTRACT,
     TOKEN_IF,
     TOKEN_EQUAL,
+    TOKEN_NOT_EQUAL,
+    TOKEN_LESS,
+    TOKEN_GREATER,
+    TOKEN_LESS_EQUAL,
+    TOKEN_GREATER_EQUAL,
+    TOKEN_AND,
+    TOKEN_OR,
+    TOKEN_NOT,
     TOKEN_LPAREN,
     TOKEN_RPAREN,
     TOKEN_LBRACE,
@@ -23,12 +31,21 @@ typedef enum {
     TOKEN_EOF
 } TokType;
 
-/* Define a struct type for the tokens*/
+/* Define a struct type for the tokens. `offset` is the byte offset of
+the first character of the token in the source and `line` is its 1-based
+line number. */
 typedef struct {
     std::string text;
     TokType type;
+    size_t offset;
+    size_t line;
 } Token;
 
 std::vector<Token> tokenizeFile(const std::string filePath);
 
+/* Tokenize the file by splitting it into `numThreads` chunks at `;` or `}`
+and lexing the chunks concurrently. Produces the same token stream as
+`tokenizeFile`. A `numThreads` of 0 uses the hardware concurrency. */
+std::vector<Token> tokenizeFileParallel(const std::string filePath, unsigned numThreads);
+
 #endif
\ No newline at end of file
@@ -2,29 +2,95 @@
 #include <vector>
 #include <string>
 #include <fstream>
+#include <chrono>
+#include <algorithm>
+#include <cctype>
 
 #include "lexer.h"
 #include "parser.h"
 #include "codegen.h"
 
-std::string getOutputFileName(const std::string& inputFile) {
+std::string getOutputFileName(const std::string& inputFile, const std::string& extension) {
     size_t lastDot = inputFile.find_last_of('.');
     if (lastDot == std::string::npos) {
-        return inputFile + ".asm"; // No extension, just add .asm
+        return inputFile + extension; // No extension, just add one
     }
-    return inputFile.substr(0, lastDot) + ".asm";
+    return inputFile.substr(0, lastDot) + extension;
+}
+
+int printUsage(const char *program) {
+    std::cerr << "Usage: " << program << " <filename> [-j <threads>] [-t 8bit|x86-64] [--time-lex]" << std::endl;
+    return 1;
+}
+
+// thread counts are small non-negative integers, anything else is rejected
+bool parseThreadCount(const std::string &value, int &threads) {
+    if(value.empty() || value.size() > 4
+       || !std::all_of(value.begin(), value.end(), [](char ch) { return std::isdigit(ch); })) {
+        return false;
+    }
+    threads = std::stoi(value);
+    return true;
 }
 
 int main(int argc, char *argv[]) {
 
-    if(argc != 2) {
-        std::cerr << "Usage: " << argv[0] << " <filename>" << std::endl;
+    if(argc < 2) {
+        return printUsage(argv[0]);
     }
 
     std::vector<Token> tokens;
     const std::string file = argv[1];
-    const std::string outfile = getOutputFileName(file);
-    tokens = tokenizeFile(file);
+
+    // `-j <threads>` lexes the file in parallel chunks, 0 uses all cores
+    // `-t x86-64` emits assembly for the host instead of the 8-bit computer
+    // `--time-lex` only lexes the file and reports how long it took on stderr
+    int threads = -1;
+    std::string targetName = "8bit";
+    bool timeLexer = false;
+    for(int i = 2; i < argc; i++) {
+        const std::string option = argv[i];
+        if(option == "--time-lex") {
+            timeLexer = true;
+        } else if((option == "-j" || option == "-t") && i + 1 >= argc) {
+            std::cerr << "Missing value for " << option << std::endl;
+            return printUsage(argv[0]);
+        } else if(option == "-j") {
+            if(!parseThreadCount(argv[++i], threads)) {
+                std::cerr << "Invalid thread count: " << argv[i] << std::endl;
+                return printUsage(argv[0]);
+            }
+        } else if(option == "-t") {
+            targetName = argv[++i];
+        } else {
+            std::cerr << "Invalid option: " << option << std::endl;
+            return printUsage(argv[0]);
+        }
+    }
+
+    EightBitTarget eightBitTarget;
+    X86_64Target x86Target;
+    Target *target = &eightBitTarget;
+    std::string outfile = getOutputFileName(file, ".asm");
+    if(targetName == "x86-64") {
+        target = &x86Target;
+        outfile = getOutputFileName(file, ".s");
+    } else if(targetName != "8bit") {
+        std::cerr << "Unknown target: " << targetName << std::endl;
+        return printUsage(argv[0]);
+    }
+
+    auto lexStart = std::chrono::steady_clock::now();
+    if(threads >= 0) {
+        tokens = tokenizeFileParallel(file, threads);
+    } else {
+        tokens = tokenizeFile(file);
+    }
+    if(timeLexer) {
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - lexStart;
+        std::cerr << "Lexed " << tokens.size() << " tokens in " << elapsed.count() << " ms" << std::endl;
+        return 0;
+    }
 
     Parser parser;
     parser.setTokens(tokens);
@@ -37,7 +103,7 @@ int main(int argc, char *argv[]) {
 
         ASTNode ast = parseProgram(parser);
         // displayAST(ast, 0);
-        auto assembly = generateProgram(ast);
+        auto assembly = generateProgram(ast, *target);
         std::ofstream outFile(outfile);
         if (!outFile) {
             throw std::runtime_error("Could not open output file: " + outfile);
@@ -71,7 +71,7 @@ ASTNode parseStatement(Parser &parser){
         } else {
             throw std::runtime_error("Semantic error: Unexpected token after identifier: '" + (*parser.tokens)[nextIndex].text + "'");
         }
-    } else if((*parser.tokens)[parser.currIndex].type == 14) {
+    } else if((*parser.tokens)[parser.currIndex].type == TOKEN_EOF) {
         // reached EOF
         parser.currIndex++;
         return ASTNode{"eof", {}, ""};
@@ -211,21 +211,80 @@ ASTNode parseConditional(Parser &parser) {
 }
 
 ASTNode parseCondition(Parser &parser) {
-    // <condition> ::= <expression> "==" <expression>
+    // <condition> ::= <and_condition> <condition_tail>
+    // <condition_tail> ::= "||" <and_condition> <condition_tail> | E
+    ASTNode left = parseAndCondition(parser);
+    while((*parser.tokens)[parser.currIndex].text == "||") {
+        parser.currIndex++;
+        ASTNode right = parseAndCondition(parser);
+        left = {
+            "logical_op",
+            {{"left", {left}},
+            {"right", {right}}},
+            "||"
+        };
+    }
+    return left;
+}
+
+ASTNode parseAndCondition(Parser &parser) {
+    // <and_condition> ::= <not_condition> <and_condition_tail>
+    // <and_condition_tail> ::= "&&" <not_condition> <and_condition_tail> | E
+    ASTNode left = parseNotCondition(parser);
+    while((*parser.tokens)[parser.currIndex].text == "&&") {
+        parser.currIndex++;
+        ASTNode right = parseNotCondition(parser);
+        left = {
+            "logical_op",
+            {{"left", {left}},
+            {"right", {right}}},
+            "&&"
+        };
+    }
+    return left;
+}
+
+ASTNode parseNotCondition(Parser &parser) {
+    // <not_condition> ::= "!" <not_condition> | "(" <condition> ")" | <comparison>
+    if((*parser.tokens)[parser.currIndex].text == "!") {
+        parser.currIndex++;
+        ASTNode operand = parseNotCondition(parser);
+        return {"logical_not", {{"operand", {operand}}}, "!"};
+    }
+    if((*parser.tokens)[parser.currIndex].text == "(") {
+        // expressions have no parentheses so this is a grouped condition
+        parser.currIndex++;
+        ASTNode condition = parseCondition(parser);
+        if((*parser.tokens)[parser.currIndex].text != ")") {
+            throw std::runtime_error("Expected ')' got '" + (*parser.tokens)[parser.currIndex].text + "'");
+        }
+        parser.currIndex++;
+        return condition;
+    }
+    return parseComparison(parser);
+}
+
+ASTNode parseComparison(Parser &parser) {
+    // <comparison> ::= <expression> <relational_op> <expression>
     ASTNode left = parseExpression(parser);
-    if((*parser.tokens)[parser.currIndex].text != "==") {
-        throw std::runtime_error("Expected '==' got '" + (*parser.tokens)[parser.currIndex].text + "'");
+    if(!isRelationalOperator((*parser.tokens)[parser.currIndex].text)) {
+        throw std::runtime_error("Expected a comparison operator got '" + (*parser.tokens)[parser.currIndex].text + "'");
     }
-    parser.currIndex++;
+    std::string op = (*parser.tokens)[parser.currIndex++].text;
     ASTNode right = parseExpression(parser);
     return {
         "condition",
         {{"left", {left}},
         {"right", {right}}},
-        "=="
+        op
     };
 }
 
+bool isRelationalOperator(const std::string &token) {
+    return token == "==" || token == "!=" || token == "<"
+           || token == ">" || token == "<=" || token == ">=";
+}
+
 bool isIdentifier(const std::string &token) {
     return !token.empty() && std::isalpha(token[0]);
 }
@@ -36,11 +36,15 @@ ASTNode parseExpression(Parser &parser);
 ASTNode parseExpressionTail(Parser &parser, ASTNode left);
 ASTNode parseConditional(Parser &parser);
 ASTNode parseCondition(Parser &parser);
+ASTNode parseAndCondition(Parser &parser);
+ASTNode parseNotCondition(Parser &parser);
+ASTNode parseComparison(Parser &parser);
 ASTNode parseIdentifier(Parser &parser);
 ASTNode parseNumber(Parser &parser);
 ASTNode parseTerm(Parser &parser);
 bool isIdentifier(const std::string& token);
 bool isNumber(const std::string& token);
+bool isRelationalOperator(const std::string& token);
 void displayAST(const ASTNode &node, int indentLevel);
 
 #endif // PARSER_H
\ No newline at end of file